@@ -20,6 +20,7 @@ struct dataset{
 	int 			numMembers;		/* The number of members in the set */
 	int 			numInputs;		/* The number of inputs in the set */
 	int 			numOutputs;		/* The number of outputs in the set */
+	unsigned long	id;				/* Unique id given when the set is loaded */
 };
 
 typedef struct neuron{
@@ -41,8 +42,36 @@ struct mlpNetwork{
 	int				learning;		/* The learning type of the network */
 	int				epoch;			/* The current epoch */
 	int				epochMax;		/* The maximum number of epochs */
+	int				numFrozen;		/* The number of leading layers not trained */
+	double*			frozenCache;	/* Cached outputs of the last frozen layer */
+	unsigned long	cacheId;		/* The id of the dataset the cache was built from */
+	unsigned long	failedId;		/* The id of the dataset the cache couldn't be built for */
 };
 
+/*
+	An ensemble holds numNets networks of the same shape. Each value is
+	stored for every network side by side, i.e. weight k of neuron j is
+	at [(j*(inputs+1) + k)*numNets + net], so the inner loops over the
+	networks run across contiguous memory.
+*/
+struct mlpEnsemble{
+	double**		weights;		/* Interleaved weights of each layer */
+	double**		deltaWeights;	/* Interleaved weight changes of each layer */
+	double**		outputs;		/* Interleaved neuron outputs of each layer */
+	double**		deltas;			/* Interleaved neuron deltas of each layer */
+	int*			numNeurons;		/* Number of neurons in each layer */
+	int 			numLayers;		/* The number of layers in each network */
+	int				numInputs;		/* The number of inputs to each network */
+	int				numNets;		/* The number of networks in the ensemble */
+	int				type;			/* The activation type of the neurons */
+	double*			learnRate;		/* The learning rate of each network */
+	double*			momentum;		/* The momentum of each network */
+	double*			sumSqErrors;	/* The sum squared errors of each network */
+};
+
+/* The id given to the last dataset loaded, 0 is never used */
+static unsigned long lastDatasetId = 0;
+
 double sqr(double val){ return (val*val); }
 
 double scale(double val, double min, double max, int type){
@@ -90,6 +119,7 @@ dataset * loadData(char* filename, char* name){
 	ptrDataset->numMembers = numMembers;  
 	ptrDataset->numInputs = numInputs;
 	ptrDataset->numOutputs = numOutputs;
+	ptrDataset->id = ++lastDatasetId;
 	
 	/* Allocate memory for the arrays in the dataset */
 	if((ptrDataset->members = (dataMember*) malloc(numMembers * sizeof(dataMember))) != NULL)
@@ -224,6 +254,48 @@ void setLearnParameters(mlpNetwork* net, int emax, double learnRate, double mome
 	if (momentum >= 0.0) net->momentum = momentum;
 }
 
+/*
+	Discard the cached outputs of the frozen layers, so the next
+	call to trainNetworkOnce recomputes them
+*/
+void clearFrozenCache(mlpNetwork* net){
+	free(net->frozenCache);
+	net->frozenCache = NULL;
+	net->cacheId = 0;
+	net->failedId = 0;
+}
+
+/*
+	This function stops the first numFrozen layers from being trained.
+	At least the output layer must be left trainable.
+*/
+void freezeLayers(mlpNetwork* net, int numFrozen){
+	int i, j, k;
+	neuron* nTemp;
+	
+	if(numFrozen < 0){
+		printf("Can't freeze a negative number of layers\n");
+		return;
+	}
+	if(numFrozen >= net->numLayers){
+		printf("Must leave at least the output layer unfrozen\n");
+		return;
+	}
+	
+	/* Layers being unfrozen mustn't carry momentum from before the freeze */
+	for(i=numFrozen; i< net->numFrozen; i++){
+		for(j=0; j< net->numNeurons[i]; j++){
+			nTemp = (net->layers[i])+j;
+			for(k=0; k<= nTemp->numInputs; k++){
+				nTemp->deltaWeights[k] = 0;
+			}
+		}
+	}
+	
+	if(numFrozen != net->numFrozen) clearFrozenCache(net);
+	net->numFrozen = numFrozen;
+}
+
 /*
 	This function is used to set the weights for each neuron
 */
@@ -233,6 +305,9 @@ void setWeights(mlpNetwork* net, double* weights){
 	neuron* layer;
 	neuron* nTemp;
 	
+	/* The cached outputs no longer match the weights */
+	clearFrozenCache(net);
+	
 	/* For each layer */
 	for(i=0; i<net->numLayers; i++){
 		/* For each neuron in the layer */
@@ -250,6 +325,27 @@ void setWeights(mlpNetwork* net, double* weights){
 	}
 }
 
+/*
+	This function gets the weights of each neuron, in the same order as setWeights
+*/
+void getWeights(mlpNetwork* net, double* weights){
+	int i, j, k;
+	int wCnt=0;
+	neuron* nTemp;
+	
+	/* For each layer */
+	for(i=0; i<net->numLayers; i++){
+		/* For each neuron in the layer */
+		for(j=0; j< net->numNeurons[i]; j++){
+			nTemp = (net->layers[i])+j;
+			/* For each weight for the neuron */
+			for(k=0; k<= nTemp->numInputs; k++){
+				weights[wCnt++] = nTemp->weights[k];
+			}
+		}
+	}
+}
+
 /*
 	Helper function which runs the network on a single data member
 */
@@ -277,8 +373,8 @@ void adaptNetwork(mlpNetwork* net, double* errors, double* inputs){
 	
 	/* First, calculate the deltas */
 	
-	/* For each layer from the last to the first */
-	for(i=net->numLayers-1; i>=0; i--){
+	/* For each layer from the last to the first unfrozen one */
+	for(i=net->numLayers-1; i>=net->numFrozen; i--){
 		/* For each neuron in the layer */
 		for(j=0; j< net->numNeurons[i]; j++){
 			
@@ -305,8 +401,8 @@ void adaptNetwork(mlpNetwork* net, double* errors, double* inputs){
 		}
 	} 
 	/* Then, calculate the required deltaWeights */
-	/* For each layer in the network */
-	for(i=0; i< net->numLayers; i++){
+	/* For each unfrozen layer in the network */
+	for(i=net->numFrozen; i< net->numLayers; i++){
 		/* For each neuron in the layer */
 		for(j=0; j< net->numNeurons[i]; j++){
 			/*For each weight in the neuron */
@@ -361,27 +457,22 @@ void computeNeuron(neuron* cell){
 	}
 }
 
-void computeNetwork(mlpNetwork* net, dataMember* datum, int numIn, int numOut){
+void computeLayers(mlpNetwork* net, int first, int last){
 	int i,j;
-	neuron* out;
-	double** inPtrs;
 	
-	/* Store the addresses of the inputs in an array */
-	inPtrs = (double**) malloc(numIn * sizeof(double*));
-	for(i=0; i< numIn; i++){
-		inPtrs[i] = datum->inputs+i;
-	}
-	/* Then map the inputs for the first layer to them */
-	connectInputs(net, inPtrs, 0);
-	
-	/* For each layer */
-	for(i=0; i< net->numLayers; i++){
+	/* For each layer from first up to (not including) last */
+	for(i=first; i< last; i++){
 		/* For each neuron in that layer */
 		for(j=0; j< net->numNeurons[i]; j++){
 			/* Compute the neuron output */
 			computeNeuron(*(net->layers+i)+j);
 		}
 	}
+}
+
+void storeOutputs(mlpNetwork* net, dataMember* datum, int numOut){
+	int i;
+	neuron* out;
 	
 	/* For each output */
 	for(i=0; i<numOut; i++){
@@ -391,10 +482,99 @@ void computeNetwork(mlpNetwork* net, dataMember* datum, int numIn, int numOut){
 		/* Calculate and store the error (target - output) */
 		datum->errors[i] = datum->targets[i] - datum->outputs[i];
 	}
+}
+
+void computeNetwork(mlpNetwork* net, dataMember* datum, int numIn, int numOut){
+	int i;
+	double** inPtrs;
+	
+	/* Store the addresses of the inputs in an array */
+	inPtrs = (double**) malloc(numIn * sizeof(double*));
+	for(i=0; i< numIn; i++){
+		inPtrs[i] = datum->inputs+i;
+	}
+	/* Then map the inputs for the first layer to them */
+	connectInputs(net, inPtrs, 0);
+	
+	/* Compute every layer */
+	computeLayers(net, 0, net->numLayers);
+	
+	storeOutputs(net, datum, numOut);
 	
 	free(inPtrs);
 }
 
+/*
+	Helper function which computes the frozen layers once for every
+	data member, storing the outputs of the last frozen layer in a
+	numMembers x numNeurons matrix. Returns 0 if it could not be built,
+	only reporting it the first time for each dataset.
+*/
+int buildFrozenCache(mlpNetwork* net, dataset* data){
+	int i,j;
+	int width = net->numNeurons[net->numFrozen-1];
+	double** inPtrs;
+	double* row;
+	neuron* last;
+	
+	if(net->failedId == data->id) return (0);
+	clearFrozenCache(net);
+	
+	if((net->frozenCache = (double*) malloc((size_t)data->numMembers * width * sizeof(double))) == NULL){
+		printf("Couldn't cache the frozen layers\n");
+		net->failedId = data->id;
+		return (0);
+	}
+	if((inPtrs = (double**) malloc(data->numInputs * sizeof(double*))) == NULL){
+		printf("Couldn't cache the frozen layers\n");
+		clearFrozenCache(net);
+		net->failedId = data->id;
+		return (0);
+	}
+	
+	/* For each datamember */
+	for(i=0; i< data->numMembers; i++){
+		/* Map the inputs for the first layer to the member's inputs */
+		for(j=0; j< data->numInputs; j++){
+			inPtrs[j] = (data->members+i)->inputs+j;
+		}
+		connectInputs(net, inPtrs, 0);
+		
+		/* Compute only the frozen layers */
+		computeLayers(net, 0, net->numFrozen);
+		
+		/* Store the outputs of the last frozen layer */
+		last = net->layers[net->numFrozen-1];
+		row = net->frozenCache + (size_t)i*width;
+		for(j=0; j< width; j++){
+			row[j] = (last+j)->output;
+		}
+	}
+	
+	free(inPtrs);
+	net->cacheId = data->id;
+	return (1);
+}
+
+/*
+	Helper function which runs the unfrozen layers on a single data
+	member, starting from its row in the frozen cache
+*/
+void computeFromCache(mlpNetwork* net, dataMember* datum, double* row, int numOut){
+	int i;
+	neuron* last = net->layers[net->numFrozen-1];
+	
+	/* Restore the outputs of the last frozen layer */
+	for(i=0; i< net->numNeurons[net->numFrozen-1]; i++){
+		(last+i)->output = row[i];
+	}
+	
+	/* Compute only the unfrozen layers */
+	computeLayers(net, net->numFrozen, net->numLayers);
+	
+	storeOutputs(net, datum, numOut);
+}
+
 /*
 	Function called by the user to run the network on a given dataset once
 */
@@ -480,8 +660,22 @@ void runNetworkOnce(mlpNetwork* net, dataset* data, int print){
 */
 void trainNetworkOnce(mlpNetwork* net, dataset* data, int print){
 	int i;
+	int width;
 	/* Consider mode (batch / online) */
 	
+	/* If layers are frozen, their outputs only need computing once */
+	if(net->numFrozen > 0){
+		if(net->cacheId == data->id || buildFrozenCache(net, data)){
+			width = net->numNeurons[net->numFrozen-1];
+			/* For each datamember, compute the unfrozen layers then adapt */
+			for(i=0; i< data->numMembers; i++){
+				computeFromCache(net, data->members+i, net->frozenCache + (size_t)i*width, data->numOutputs);
+				adaptNetwork(net, (data->members+i)->errors, (data->members+i)->inputs);
+			}
+			return;
+		}
+	}
+	
 	/* For each datamemember, compute then adapt */
 	for(i=0; i< data->numMembers; i++){
 		computeNetwork(net, data->members+i, data->numInputs, data->numOutputs);
@@ -513,8 +707,9 @@ void destroyNet(mlpNetwork* net){
 		/* Followed by the layers*/
 		free(net->layers[i]);
 	}
-	/* Finally, The array of layers, the number of 
-	neurons per layer, and the net itself */
+	/* Finally, the frozen cache, the array of layers, the number
+	of neurons per layer, and the net itself */
+	free(net->frozenCache);
 	free(net->layers);
 	free(net->numNeurons);
 	free(net);
@@ -551,6 +746,12 @@ mlpNetwork* createNetwork(int numLayers, int* numPerLayer, int inputs, int learn
 	net->learnRate = 0.5;
 	net->momentum = 0.5;
 	
+	/* Start with every layer trainable */
+	net->numFrozen = 0;
+	net->frozenCache = NULL;
+	net->cacheId = 0;
+	net->failedId = 0;
+	
 	if((net->layers = (neuron**) malloc(numLayers * sizeof(neuron*))) != NULL) check |= 0x01;
 	
 	if((net->numNeurons = (int*) malloc(numLayers * sizeof(int))) != NULL) check |= 0x02;
@@ -664,4 +865,365 @@ mlpNetwork* createNetwork(int numLayers, int* numPerLayer, int inputs, int learn
 	return (net);
 }
 
+/*
+	Finally, define the functions for training an ensemble of networks
+	with the same shape, each with its own weights and learn parameters,
+	using a single pass over the dataset.
+*/
+
+void destroyEnsemble(mlpEnsemble* ens){
+	int i;
+	
+	/* First the arrays for each layer */
+	if(ens->weights != NULL){
+		for(i=0; i< ens->numLayers; i++){
+			free(ens->weights[i]);
+			free(ens->deltaWeights[i]);
+			free(ens->outputs[i]);
+			free(ens->deltas[i]);
+		}
+	}
+	/* Then the arrays of layers, the per network values, and the ensemble itself */
+	free(ens->weights);
+	free(ens->deltaWeights);
+	free(ens->outputs);
+	free(ens->deltas);
+	free(ens->numNeurons);
+	free(ens->learnRate);
+	free(ens->momentum);
+	free(ens->sumSqErrors);
+	free(ens);
+}
+
+mlpEnsemble* createEnsemble(int numNets, int numLayers, int* numPerLayer, int inputs, int defaultActivation){
+	int i, nIn, size;
+	char check = 0x00;
+	mlpEnsemble* ens;
+	
+	/* Check Validity */
+	if(numNets < 1 || numLayers < 1 || inputs < 1){
+		printf("\n Must specify 1 or more Networks, Layers and/or inputs \n");
+		return (NULL);
+	}
+	if(   defaultActivation != LIN_ACTIVATION
+	   && defaultActivation != SIG_ACTIVATION){
+		printf("Activation method not recognised\n");
+		return (NULL);
+	}
+	
+	if((ens = (mlpEnsemble*) calloc(1, sizeof(mlpEnsemble))) == NULL) return (NULL);
+	ens->numNets = numNets;
+	ens->numLayers = numLayers;
+	ens->numInputs = inputs;
+	ens->type = defaultActivation;
+	
+	/* Allocate the arrays of layers, zeroed so they can be freed if we fail */
+	if((ens->weights = (double**) calloc(numLayers, sizeof(double*))) != NULL) check |= 0x01;
+	if((ens->deltaWeights = (double**) calloc(numLayers, sizeof(double*))) != NULL) check |= 0x02;
+	if((ens->outputs = (double**) calloc(numLayers, sizeof(double*))) != NULL) check |= 0x04;
+	if((ens->deltas = (double**) calloc(numLayers, sizeof(double*))) != NULL) check |= 0x08;
+	if((ens->numNeurons = (int*) malloc(numLayers * sizeof(int))) != NULL) check |= 0x10;
+	
+	/* Allocate the per network values */
+	if((ens->learnRate = (double*) malloc(numNets * sizeof(double))) != NULL) check |= 0x20;
+	if((ens->momentum = (double*) malloc(numNets * sizeof(double))) != NULL) check |= 0x40;
+	
+	if(check < 0x7F || (ens->sumSqErrors = (double*) calloc(numNets, sizeof(double))) == NULL){
+		printf("Couldn't create ensemble\n");
+		/* Only free the layers if every array of layers exists */
+		if((check & 0x0F) != 0x0F){
+			free(ens->weights);
+			ens->weights = NULL;
+		}
+		destroyEnsemble(ens);
+		return (NULL);
+	}
+	
+	/* Set a default in case they don't get set */
+	for(i=0; i< numNets; i++){
+		ens->learnRate[i] = 0.5;
+		ens->momentum[i] = 0.5;
+	}
+	
+	/* Create the layers, with weights and changes starting at 0 */
+	for(i=0; i< numLayers; i++){
+		ens->numNeurons[i] = numPerLayer[i];
+		
+		/* The number of inputs to the neurons in this layer */
+		if(i==0) nIn = inputs;
+		else nIn = numPerLayer[i-1];
+		
+		size = numPerLayer[i] * (nIn+1) * numNets;
+		check = 0x00;
+		if((ens->weights[i] = (double*) calloc(size, sizeof(double))) != NULL) check |= 0x01;
+		if((ens->deltaWeights[i] = (double*) calloc(size, sizeof(double))) != NULL) check |= 0x02;
+		if((ens->outputs[i] = (double*) calloc(numPerLayer[i] * numNets, sizeof(double))) != NULL) check |= 0x04;
+		if((ens->deltas[i] = (double*) calloc(numPerLayer[i] * numNets, sizeof(double))) != NULL) check |= 0x08;
+		
+		if(check < 0x0F){
+			printf("Couldn't create ensemble\n");
+			destroyEnsemble(ens);
+			return (NULL);
+		}
+	}
+	
+	return (ens);
+}
+
+void setEnsembleLearnParameters(mlpEnsemble* ens, int net, double learnRate, double momentum){
+	if(net < 0 || net >= ens->numNets){
+		printf("Network %d is not in the ensemble\n", net);
+		return;
+	}
+	if (learnRate >= 0.0) ens->learnRate[net] = learnRate;
+	if (momentum >= 0.0) ens->momentum[net] = momentum;
+}
+
+/*
+	These functions set and get the weights of one network in the
+	ensemble, in the same order as setWeights
+*/
+void setEnsembleWeights(mlpEnsemble* ens, int net, double* weights){
+	int i, j;
+	int wCnt=0;
+	int nIn;
+	
+	if(net < 0 || net >= ens->numNets){
+		printf("Network %d is not in the ensemble\n", net);
+		return;
+	}
+	
+	/* For each layer */
+	for(i=0; i< ens->numLayers; i++){
+		if(i==0) nIn = ens->numInputs;
+		else nIn = ens->numNeurons[i-1];
+		/* For each weight of each neuron in the layer */
+		for(j=0; j< ens->numNeurons[i] * (nIn+1); j++){
+			/* Set the weight */
+			ens->weights[i][j*ens->numNets + net] = weights[wCnt++];
+			/* Set the previous change to 0 */
+			ens->deltaWeights[i][j*ens->numNets + net] = 0.0;
+		}
+	}
+}
+
+void getEnsembleWeights(mlpEnsemble* ens, int net, double* weights){
+	int i, j;
+	int wCnt=0;
+	int nIn;
+	
+	if(net < 0 || net >= ens->numNets){
+		printf("Network %d is not in the ensemble\n", net);
+		return;
+	}
+	
+	/* For each layer */
+	for(i=0; i< ens->numLayers; i++){
+		if(i==0) nIn = ens->numInputs;
+		else nIn = ens->numNeurons[i-1];
+		/* For each weight of each neuron in the layer */
+		for(j=0; j< ens->numNeurons[i] * (nIn+1); j++){
+			weights[wCnt++] = ens->weights[i][j*ens->numNets + net];
+		}
+	}
+}
+
+/*
+	Returns the sum squared error of one network over the last call
+	to trainEnsembleOnce
+*/
+double getEnsembleError(mlpEnsemble* ens, int net){
+	if(net < 0 || net >= ens->numNets){
+		printf("Network %d is not in the ensemble\n", net);
+		return (-1.0);
+	}
+	return (ens->sumSqErrors[net]);
+}
+
+/*
+	Helper functions for the loops over the networks in an ensemble.
+	Their arrays never overlap, which lets the compiler vectorise them.
+*/
+void ensembleAddScaled(double* restrict out, const double* restrict w, double x, int K){
+	int m;
+	for(m=0; m<K; m++) out[m] += w[m] * x;
+}
+
+void ensembleAddWeighted(double* restrict out, const double* restrict w, const double* restrict in, int K){
+	int m;
+	for(m=0; m<K; m++) out[m] += w[m] * in[m];
+}
+
+void ensembleSigmoidDelta(double* restrict delta, const double* restrict out, int K){
+	int m;
+	for(m=0; m<K; m++) delta[m] = delta[m] * (1-out[m]) * out[m];
+}
+
+void ensembleOutputDelta(double* restrict delta, const double* restrict out, double* restrict sumSqErrors, double target, int K){
+	int m;
+	double err;
+	for(m=0; m<K; m++){
+		err = target - out[m];
+		sumSqErrors[m] += err * err;
+		delta[m] = err;
+	}
+}
+
+/* Update the weights for an input shared by every network */
+void ensembleUpdateScaled(double* restrict w, double* restrict dw, const double* restrict delta, double x,
+                          const double* restrict learnRate, const double* restrict momentum, int K){
+	int m;
+	for(m=0; m<K; m++){
+		dw[m] = learnRate[m] * x * delta[m] + momentum[m] * dw[m];
+		w[m] += dw[m];
+	}
+}
+
+/* Update the weights for an input which differs between the networks */
+void ensembleUpdateWeighted(double* restrict w, double* restrict dw, const double* restrict delta, const double* restrict in,
+                            const double* restrict learnRate, const double* restrict momentum, int K){
+	int m;
+	for(m=0; m<K; m++){
+		dw[m] = learnRate[m] * in[m] * delta[m] + momentum[m] * dw[m];
+		w[m] += dw[m];
+	}
+}
+
+/*
+	Helper function which runs every network in the ensemble on a
+	single data member
+*/
+void computeEnsemble(mlpEnsemble* ens, dataMember* datum){
+	int i, j, k, m;
+	int K = ens->numNets;
+	int nIn;
+	double* out;
+	double* w;
+	
+	/* For each layer */
+	for(i=0; i< ens->numLayers; i++){
+		if(i==0) nIn = ens->numInputs;
+		else nIn = ens->numNeurons[i-1];
+		
+		/* For each neuron in that layer */
+		for(j=0; j< ens->numNeurons[i]; j++){
+			out = ens->outputs[i] + j*K;
+			w = ens->weights[i] + j*(nIn+1)*K;
+			
+			/* Start with the bias */
+			memcpy(out, w, K * sizeof(double));
+			
+			/* Sum the inputs */
+			for(k=0; k< nIn; k++){
+				w += K;
+				if(i==0){ /* The data input is shared by every network */
+					ensembleAddScaled(out, w, datum->inputs[k], K);
+				}else{ /* Otherwise use each network's previous layer outputs */
+					ensembleAddWeighted(out, w, ens->outputs[i-1] + k*K, K);
+				}
+			}
+			
+			if(ens->type == LIN_ACTIVATION){
+				/* Do Nothing (output = sum of inputs) */
+			}else if(ens->type == SIG_ACTIVATION){
+				/* Apply sigmoid function */
+				for(m=0; m<K; m++) out[m] = 1.0 / (1.0 + exp(-out[m]));
+			}else{
+				/* Set ouput to 0.0*/
+				for(m=0; m<K; m++) out[m] = 0.0;
+			}
+		}
+	}
+}
+
+/*
+	Helper function which adapts every network in the ensemble to the
+	errors of a single data member, and adds them to the sumSqErrors
+*/
+void adaptEnsemble(mlpEnsemble* ens, dataMember* datum){
+	int i, j, k;
+	int K = ens->numNets;
+	int last = ens->numLayers-1;
+	int nIn;
+	double* out;
+	double* delta;
+	double* w;
+	double* dw;
+	
+	/* First, calculate the deltas */
+	
+	/* The final layer uses the errors (target - output) */
+	for(j=0; j< ens->numNeurons[last]; j++){
+		out = ens->outputs[last] + j*K;
+		delta = ens->deltas[last] + j*K;
+		ensembleOutputDelta(delta, out, ens->sumSqErrors, datum->targets[j], K);
+		/* If sigmoidal, do some extra processing */
+		if(ens->type == SIG_ACTIVATION) ensembleSigmoidDelta(delta, out, K);
+	}
+	
+	/* The others use the sum of next layers (deltas * weights) */
+	for(i=last-1; i>=0; i--){
+		for(j=0; j< ens->numNeurons[i]; j++){
+			out = ens->outputs[i] + j*K;
+			delta = ens->deltas[i] + j*K;
+			memset(delta, 0, K * sizeof(double));
+			
+			/* For each neuron in the next layer */
+			for(k=0; k< ens->numNeurons[i+1]; k++){
+				w = ens->weights[i+1] + (k*(ens->numNeurons[i]+1) + j+1)*K;
+				ensembleAddWeighted(delta, w, ens->deltas[i+1] + k*K, K);
+			}
+			
+			/* If sigmoidal, do some extra processing */
+			if(ens->type == SIG_ACTIVATION) ensembleSigmoidDelta(delta, out, K);
+		}
+	}
+	
+	/* Then, calculate the required deltaWeights */
+	/* For each layer in the networks */
+	for(i=0; i<= last; i++){
+		if(i==0) nIn = ens->numInputs;
+		else nIn = ens->numNeurons[i-1];
+		
+		/* For each neuron in the layer */
+		for(j=0; j< ens->numNeurons[i]; j++){
+			delta = ens->deltas[i] + j*K;
+			w = ens->weights[i] + j*(nIn+1)*K;
+			dw = ens->deltaWeights[i] + j*(nIn+1)*K;
+			
+			/* For each weight in the neuron, k==0 is the bias */
+			for(k=0; k<= nIn; k++){
+				if(k==0){ /* The bias input is 1.0 for every network */
+					ensembleUpdateScaled(w, dw, delta, 1.0, ens->learnRate, ens->momentum, K);
+				}else if(i==0){ /* The data input is shared by every network */
+					ensembleUpdateScaled(w, dw, delta, datum->inputs[k-1], ens->learnRate, ens->momentum, K);
+				}else{ /* Otherwise use each network's previous layer outputs */
+					ensembleUpdateWeighted(w, dw, delta, ens->outputs[i-1] + (k-1)*K, ens->learnRate, ens->momentum, K);
+				}
+				w += K;
+				dw += K;
+			}
+		}
+	}
+}
+
+/*
+	Function called by the user to train every network in the ensemble
+	once, reading each data member only once for all of them
+*/
+void trainEnsembleOnce(mlpEnsemble* ens, dataset* data){
+	int i;
+	
+	/* First initialise the sumSqErrors to 0.0 */
+	for(i=0; i< ens->numNets; i++){
+		ens->sumSqErrors[i] = 0.0;
+	}
+	
+	/* For each datamemember, compute then adapt */
+	for(i=0; i< data->numMembers; i++){
+		computeEnsemble(ens, data->members+i);
+		adaptEnsemble(ens, data->members+i);
+	}
+}
+
 
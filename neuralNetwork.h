@@ -13,16 +13,29 @@
 
 typedef struct dataset dataset;
 typedef struct mlpNetwork mlpNetwork;
+typedef struct mlpEnsemble mlpEnsemble;
 
 dataset * loadData(char* filename, char* name);
 void destroyDataset(dataset* ptrDataset);
 
 void setLearnParameters(mlpNetwork* Net, int emax, double learnRate, double momentum);
 void setWeights(mlpNetwork* net, double* weights);
+void getWeights(mlpNetwork* net, double* weights);
+void freezeLayers(mlpNetwork* net, int numFrozen);
+void clearFrozenCache(mlpNetwork* net);
 void runNetworkOnce(mlpNetwork* net, dataset* data, int print);
 void trainNetworkOnce(mlpNetwork* net, dataset* data, int print);
 
 void destroyNet(mlpNetwork* net);
 mlpNetwork* createNetwork(int numLayers, int* numPerLayer, int inputs, int learnMethod, int defaultActivation);
 
+void setEnsembleLearnParameters(mlpEnsemble* ens, int net, double learnRate, double momentum);
+void setEnsembleWeights(mlpEnsemble* ens, int net, double* weights);
+void getEnsembleWeights(mlpEnsemble* ens, int net, double* weights);
+double getEnsembleError(mlpEnsemble* ens, int net);
+void trainEnsembleOnce(mlpEnsemble* ens, dataset* data);
+
+void destroyEnsemble(mlpEnsemble* ens);
+mlpEnsemble* createEnsemble(int numNets, int numLayers, int* numPerLayer, int inputs, int defaultActivation);
+
 #endif	/* NEURAL_NETWORK_H */	
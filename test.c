@@ -0,0 +1,232 @@
+#include "neuralNetwork.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+/*
+	A small driver which checks the library against itself.
+	Run it with "make test"; it returns non-zero if any check fails.
+*/
+
+#define NUM_MEMBERS	20
+#define NUM_INPUTS	3
+#define NUM_OUTPUTS	1
+#define MAX_WEIGHTS	64
+
+int failures = 0;
+
+/* A simple repeatable random number in [-0.5, 0.5] */
+double randomValue(unsigned long* seed){
+	*seed = (*seed * 1103515245UL + 12345UL) % 2147483648UL;
+	return ( (double)(*seed % 10000) / 10000.0 - 0.5 );
+}
+
+/*
+	Write a dataset file in the format read by loadData
+*/
+int writeData(char* filename, unsigned long seed){
+	FILE* ptrDataFile;
+	int i,j;
+
+	if( (ptrDataFile = fopen(filename, "w"))==NULL){
+		perror(NULL);
+		return (0);
+	}
+
+	fprintf(ptrDataFile, "%d, %d, %d\n", NUM_MEMBERS, NUM_INPUTS, NUM_OUTPUTS);
+	/* The max and mins */
+	for(i=0; i< NUM_INPUTS+NUM_OUTPUTS-1; i++) fprintf(ptrDataFile, "1, ");
+	fprintf(ptrDataFile, "1\n");
+	for(i=0; i< NUM_INPUTS+NUM_OUTPUTS-1; i++) fprintf(ptrDataFile, "-1, ");
+	fprintf(ptrDataFile, "-1\n");
+
+	/* The members */
+	for(i=0; i< NUM_MEMBERS; i++){
+		for(j=0; j< NUM_INPUTS+NUM_OUTPUTS-1; j++){
+			fprintf(ptrDataFile, "%lf, ", 2.0*randomValue(&seed));
+		}
+		fprintf(ptrDataFile, "%lf\n", 2.0*randomValue(&seed));
+	}
+
+	fclose(ptrDataFile);
+	return (1);
+}
+
+int countWeights(int numLayers, int* numPerLayer){
+	int i, count=0, inputs=NUM_INPUTS;
+
+	for(i=0; i< numLayers; i++){
+		count += numPerLayer[i] * (inputs+1);
+		inputs = numPerLayer[i];
+	}
+	return (count);
+}
+
+void check(int passed, char* name){
+	printf("%s: %s\n", passed ? "PASS" : "FAIL", name);
+	if(!passed) failures++;
+}
+
+/* Returns the number of weights which differ between the two arrays */
+int compareWeights(double* a, double* b, int numWeights){
+	int i, diff=0;
+
+	for(i=0; i< numWeights; i++){
+		if(a[i] != b[i]) diff++;
+	}
+	return (diff);
+}
+
+/*
+	Training from the frozen cache must match rebuilding it every
+	epoch, and must leave the frozen weights unchanged
+*/
+void testFrozenCache(dataset* data, int numFrozen){
+	int numPerLayer[3] = {4, 3, NUM_OUTPUTS};
+	int numWeights = countWeights(3, numPerLayer);
+	int frozenWeights = countWeights(numFrozen, numPerLayer);
+	double start[MAX_WEIGHTS], a[MAX_WEIGHTS], b[MAX_WEIGHTS];
+	unsigned long seed = 42;
+	mlpNetwork* cached;
+	mlpNetwork* rebuilt;
+	int i;
+	char name[80];
+
+	for(i=0; i< numWeights; i++) start[i] = randomValue(&seed);
+
+	cached = createNetwork(3, numPerLayer, NUM_INPUTS, BPROP_LEARNING, SIG_ACTIVATION);
+	rebuilt = createNetwork(3, numPerLayer, NUM_INPUTS, BPROP_LEARNING, SIG_ACTIVATION);
+	setWeights(cached, start);
+	setWeights(rebuilt, start);
+	freezeLayers(cached, numFrozen);
+	freezeLayers(rebuilt, numFrozen);
+
+	for(i=0; i< 50; i++){
+		trainNetworkOnce(cached, data, 0);
+		trainNetworkOnce(rebuilt, data, 0);
+		clearFrozenCache(rebuilt);
+	}
+	getWeights(cached, a);
+	getWeights(rebuilt, b);
+
+	sprintf(name, "%d frozen layer(s), cached matches rebuilt", numFrozen);
+	check(compareWeights(a, b, numWeights) == 0, name);
+	sprintf(name, "%d frozen layer(s), frozen weights unchanged", numFrozen);
+	check(compareWeights(a, start, frozenWeights) == 0, name);
+	sprintf(name, "%d frozen layer(s), unfrozen weights trained", numFrozen);
+	check(compareWeights(a, start, numWeights) > 0, name);
+
+	destroyNet(cached);
+	destroyNet(rebuilt);
+}
+
+/*
+	A dataset loaded after another is destroyed must not reuse the
+	cache built from the first, even if it gets the same address
+*/
+void testReloadedDataset(void){
+	int numPerLayer[3] = {4, 3, NUM_OUTPUTS};
+	int numWeights = countWeights(3, numPerLayer);
+	double start[MAX_WEIGHTS], a[MAX_WEIGHTS], b[MAX_WEIGHTS];
+	unsigned long seed = 7;
+	mlpNetwork* cached;
+	mlpNetwork* rebuilt;
+	dataset* data;
+	int i;
+
+	for(i=0; i< numWeights; i++) start[i] = randomValue(&seed);
+
+	cached = createNetwork(3, numPerLayer, NUM_INPUTS, BPROP_LEARNING, SIG_ACTIVATION);
+	rebuilt = createNetwork(3, numPerLayer, NUM_INPUTS, BPROP_LEARNING, SIG_ACTIVATION);
+	setWeights(cached, start);
+	setWeights(rebuilt, start);
+	freezeLayers(cached, 1);
+	freezeLayers(rebuilt, 1);
+
+	data = loadData("testData1.txt", "first");
+	for(i=0; i< 10; i++){
+		trainNetworkOnce(cached, data, 0);
+		trainNetworkOnce(rebuilt, data, 0);
+		clearFrozenCache(rebuilt);
+	}
+	destroyDataset(data);
+
+	data = loadData("testData2.txt", "second");
+	for(i=0; i< 10; i++){
+		trainNetworkOnce(cached, data, 0);
+		trainNetworkOnce(rebuilt, data, 0);
+		clearFrozenCache(rebuilt);
+	}
+	destroyDataset(data);
+
+	getWeights(cached, a);
+	getWeights(rebuilt, b);
+	check(compareWeights(a, b, numWeights) == 0, "reloaded dataset rebuilds the cache");
+
+	destroyNet(cached);
+	destroyNet(rebuilt);
+}
+
+/*
+	Each network in an ensemble must train exactly as the same
+	network trained on its own
+*/
+void testEnsemble(dataset* data){
+	int numPerLayer[3] = {4, 3, NUM_OUTPUTS};
+	int numWeights = countWeights(3, numPerLayer);
+	double start[MAX_WEIGHTS], a[MAX_WEIGHTS], b[MAX_WEIGHTS];
+	double learnRate[5] = {0.1, 0.3, 0.5, 0.7, 0.9};
+	double momentum[5] = {0.0, 0.2, 0.4, 0.6, 0.8};
+	unsigned long seed = 99;
+	mlpEnsemble* ens;
+	mlpNetwork* nets[5];
+	int i, j, diff=0;
+
+	ens = createEnsemble(5, 3, numPerLayer, NUM_INPUTS, SIG_ACTIVATION);
+	for(i=0; i< 5; i++){
+		for(j=0; j< numWeights; j++) start[j] = randomValue(&seed);
+		nets[i] = createNetwork(3, numPerLayer, NUM_INPUTS, BPROP_LEARNING, SIG_ACTIVATION);
+		setWeights(nets[i], start);
+		setLearnParameters(nets[i], -1, learnRate[i], momentum[i]);
+		setEnsembleWeights(ens, i, start);
+		setEnsembleLearnParameters(ens, i, learnRate[i], momentum[i]);
+	}
+
+	for(j=0; j< 50; j++){
+		trainEnsembleOnce(ens, data);
+		for(i=0; i< 5; i++) trainNetworkOnce(nets[i], data, 0);
+	}
+
+	for(i=0; i< 5; i++){
+		getEnsembleWeights(ens, i, a);
+		getWeights(nets[i], b);
+		diff += compareWeights(a, b, numWeights);
+		if(getEnsembleError(ens, i) < 0.0) diff++;
+		destroyNet(nets[i]);
+	}
+	check(diff == 0, "ensemble matches separately trained networks");
+
+	destroyEnsemble(ens);
+}
+
+int main(void){
+	dataset* data;
+
+	if(!writeData("testData1.txt", 1) || !writeData("testData2.txt", 2)) return (1);
+	if((data = loadData("testData1.txt", "first")) == NULL) return (1);
+
+	testFrozenCache(data, 1);
+	testFrozenCache(data, 2);
+	testReloadedDataset();
+	testEnsemble(data);
+
+	destroyDataset(data);
+	remove("testData1.txt");
+	remove("testData2.txt");
+
+	if(failures > 0){
+		printf("%d check(s) failed\n", failures);
+		return (1);
+	}
+	printf("All checks passed\n");
+	return (0);
+}